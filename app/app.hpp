@@ -0,0 +1,235 @@
+#pragma once
+
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <stdexcept>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <random>
+#include <algorithm>
+
+#include <aggregates.hpp>
+#include <publisher.hpp>
+#include <shm_transport.hpp>
+#include <subscriber.hpp>
+#include <point.hpp>
+#include <polygon.hpp>
+
+static char g_chars[] =
+    "0123456789"
+    "abcdefghijklmnopqrstuvwxyz"
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+using rhombus  = basic_polygon<point2d, 4>;
+using pentagon = basic_polygon<point2d, 5>;
+using hexagon  = basic_polygon<point2d, 6>;
+
+/*!
+ * @brief Call f with figure casted to its concrete type.
+ *
+ * @return
+ * false if figure type is unknown
+ */
+template<typename _F>
+bool visit_figure(const oop::serializable& fig, _F&& f) {
+    if (const auto r = dynamic_cast<const rhombus*>(&fig)) {
+        f(*r);
+    }
+    else if (const auto p = dynamic_cast<const pentagon*>(&fig)) {
+        f(*p);
+    }
+    else if (const auto h = dynamic_cast<const hexagon*>(&fig)) {
+        f(*h);
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+struct my_event final
+    : oop::event {
+    explicit my_event(std::shared_ptr<oop::serializable> s)
+        : serializable(std::move(s)) {
+        visit_figure(*serializable, [&](const auto& fig) {
+            size_ = sizeof fig;
+        });
+    }
+
+    std::shared_ptr<oop::serializable> serializable;
+    // Event is pushed right after construction, so this is push time
+    std::chrono::steady_clock::time_point created = std::chrono::steady_clock::now();
+
+    [[nodiscard]] size_t size() const noexcept override {
+        return size_;
+    }
+
+private:
+    size_t size_ = 0;
+};
+
+struct unique_file_writer final
+    : oop::subscriber {
+
+    unique_file_writer()
+        : rng_(std::random_device{}())
+        , dist_(0, sizeof g_chars - 2)
+        , unique_(unique_string_len, '\0') {
+        const auto generator = [&]() {
+            return g_chars[dist_(rng_)];
+        };
+        std::generate_n(unique_.begin(), unique_string_len, generator);
+    }
+
+    [[nodiscard]] std::string_view get_unique() const {
+        return unique_;
+    }
+
+private:
+    static auto constexpr unique_string_len = 16;
+
+    size_t                          file_counter_ = 0;
+    std::ofstream                   file_;
+    std::default_random_engine      rng_;
+    std::uniform_int_distribution<> dist_;
+    std::string                     unique_;
+
+    [[nodiscard]] std::string generate_unique_name() const {
+        const auto prefix    = "./out-";
+        const auto suffix    = "-";
+        const auto postfix   = ".txt";
+        const auto ix        = std::to_string(file_counter_);
+
+        std::string unique(unique_string_len, '\0');
+
+        return prefix + unique_ + suffix + ix + postfix;
+    }
+
+    void new_unique_file() {
+        const auto name = generate_unique_name();
+        file_.open(name, std::ios_base::out);
+
+        ++file_counter_;
+    }
+
+    void handle(const oop::event& e) override {
+        // Every committed batch goes to its own file
+        if (!file_.is_open()) {
+            new_unique_file();
+        }
+
+        const auto& my_e = dynamic_cast<const my_event&>(e);
+        my_e.serializable->write(file_);
+    }
+
+    void flush() override {
+        if (file_.is_open()) {
+            file_.close();
+        }
+    }
+};
+
+struct stream_writer final
+    : oop::subscriber {
+    explicit stream_writer(std::ostream& stream)
+        : stream(stream)
+    {}
+
+    std::ostream& stream;
+
+private:
+    void handle(const oop::event& e) override {
+        const auto& my_e = dynamic_cast<const my_event&>(e);
+        my_e.serializable->write(stream);
+    }
+};
+
+struct aggregates_writer final
+    : oop::subscriber {
+    oop::aggregates aggregates;
+
+private:
+    bool batch_started_ = false;
+
+    void handle(const oop::event& e) override {
+        // Keep last batch aggregates till next batch comes
+        if (!batch_started_) {
+            aggregates.new_batch();
+            batch_started_ = true;
+        }
+
+        const auto& my_e = dynamic_cast<const my_event&>(e);
+        visit_figure(*my_e.serializable, [&](const auto& fig) {
+            aggregates.add(fig);
+        });
+    }
+
+    void flush() override {
+        batch_started_ = false;
+    }
+};
+
+struct shm_writer final
+    : oop::subscriber {
+    explicit shm_writer(const std::string& name)
+        : transport(name)
+    {}
+
+    oop::shm_transport transport;
+
+private:
+    void handle(const oop::event& e) override {
+        const auto& my_e = dynamic_cast<const my_event&>(e);
+        visit_figure(*my_e.serializable, [&](const auto& fig) {
+            transport.write(oop::make_figure_record(fig));
+        });
+    }
+
+    void flush() override {
+        transport.flush();
+    }
+};
+
+inline void read_rhombus(std::istream& in, rhombus& r) {
+    auto constexpr precision = 0.000000001L;
+    for (auto& p : r) {
+        in >> p;
+    }
+    if (in.fail()) {
+        return;
+    }
+
+    constexpr size_t size = rhombus::size();
+    const double dist     = distance(r[0], r[size - 1]);
+    for (size_t i = 0; i < size - 1; i++) {
+        const double next = distance(r[i], r[i + 1]);
+        if (std::abs(dist - next) > precision) {
+            in.setstate(std::ios::failbit);
+            break;
+        }
+    }
+}
+
+/*!
+ * @brief Read figure named by command from stream.
+ *
+ * @return
+ * figure or nullptr when command is not a figure name
+ */
+inline std::shared_ptr<oop::serializable> read_figure(const std::string& command, std::istream& in) {
+    std::shared_ptr<oop::serializable> fig;
+    if (command == "rhombus") {
+        auto r = new rhombus;
+        fig.reset(r);
+        read_rhombus(in, *r);
+    }
+    else if (command == "pentagon") {
+        fig.reset(new pentagon{ in });
+    }
+    else if (command == "hexagon") {
+        fig.reset(new hexagon{ in });
+    }
+    return fig;
+}
@@ -1,110 +1,14 @@
 #include <iostream>
-#include <fstream>
-#include <stdexcept>
+#include <memory>
+#include <chrono>
 #include <string>
-#include <random>
-#include <algorithm>
 
-#include <publisher.hpp>
-#include <subscriber.hpp>
-#include <point.hpp>
-#include <polygon.hpp>
+#include "app.hpp"
 
 auto constexpr default_limit = 3;
-
-static char g_chars[] =
-    "0123456789"
-    "abcdefghijklmnopqrstuvwxyz"
-    "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
-
-using rhombus  = basic_polygon<point2d, 4>;
-using pentagon = basic_polygon<point2d, 5>;
-using hexagon  = basic_polygon<point2d, 6>;
-
-struct my_event final
-    : oop::event {
-    explicit my_event(std::shared_ptr<oop::serializable> s)
-        : serializable(std::move(s))
-    {}
-
-    std::shared_ptr<oop::serializable> serializable;
-};
-
-struct unique_file_writer final
-    : oop::subscriber {
-
-    unique_file_writer()
-        : rng_(std::random_device{}())
-        , dist_(0, sizeof g_chars - 2)
-        , unique_(unique_string_len, '\0') {
-        const auto generator = [&]() {
-            return g_chars[dist_(rng_)];
-        };
-        std::generate_n(unique_.begin(), unique_string_len, generator);
-    }
-
-    void new_unique_file() {
-        if (file_.is_open()) {
-            file_.close();
-        }
-
-        const auto name = generate_unique_name();
-        file_.open(name, std::ios_base::out);
-
-        ++file_counter_;
-    }
-
-    [[nodiscard]] std::string_view get_unique() const {
-        return unique_;
-    }
-
-private:
-    static auto constexpr unique_string_len = 16;
-
-    size_t                          file_counter_ = 0;
-    std::ofstream                   file_;
-    std::default_random_engine      rng_;
-    std::uniform_int_distribution<> dist_;
-    std::string                     unique_;
-
-    [[nodiscard]] std::string generate_unique_name() const {
-        const auto prefix    = "./out-";
-        const auto suffix    = "-";
-        const auto postfix   = ".txt";
-        const auto ix        = std::to_string(file_counter_);
-
-        std::string unique(unique_string_len, '\0');
-
-        return prefix + unique_ + suffix + ix + postfix;
-    }
-
-    void handle(const oop::event& e) override {
-        if (!file_.is_open()) {
-            throw std::logic_error("unique_file_writer: unique file is not generated");
-        }
-
-        const auto& my_e = dynamic_cast<const my_event&>(e);
-        my_e.serializable->write(file_);
-    }
-};
-
-struct stream_writer final
-    : oop::subscriber {
-    explicit stream_writer(std::ostream& stream)
-        : stream(stream)
-    {}
-
-    std::ostream& stream;
-
-private:
-    void handle(const oop::event& e) override {
-        const auto& my_e = dynamic_cast<const my_event&>(e);
-        my_e.serializable->write(stream);
-    }
-};
+auto constexpr default_delay = std::chrono::seconds(5); // commit figures older than that
 
 size_t parse_limit(int argc, char* argv[]);
-void read_rhombus(std::istream& in, rhombus& r);
 
 int main(const int argc, char* argv[]) {
     auto const limit = parse_limit(argc, argv);
@@ -113,20 +17,31 @@ int main(const int argc, char* argv[]) {
         return 1;
     }
 
-    oop::publisher     publisher;
-    stream_writer      sw(std::cout);
-    unique_file_writer fw;
-    size_t             count = 0;
+    stream_writer               sw(std::cout);
+    unique_file_writer          fw;
+    aggregates_writer           aw;
+    std::unique_ptr<shm_writer> shw;
+
+    // Publisher is destroyed first, so its routine never outlives subscribers
+    oop::publisher publisher({ limit, 0, default_delay });
 
     std::cout << "Unique name: " << fw.get_unique() << std::endl;
 
-    publisher.subscribe(&sw);
-    publisher.subscribe(&fw);
+    publisher.subscribe(&sw, oop::priority::interactive);
+    publisher.subscribe(&fw, oop::priority::bulk);
+    publisher.subscribe(&aw);
+
+    // Out-of-process subscribers attach to shared memory segment
+    if (argc == 3) {
+        shw = std::make_unique<shm_writer>(argv[2]);
+        publisher.subscribe(shw.get());
+        std::cout << "Shared memory: " << argv[2] << std::endl;
+    }
 
     std::string command;
     while(std::cin >> command) {
         if (command == "e" || command == "exit") {
-            if (count != 0) {
+            if (publisher.pending() != 0) {
                 std::cout << "You can't exit till have uncommitted figures.\n"
                              "Type `force' to commit immediately." << std::endl;
                 continue;
@@ -134,41 +49,28 @@ int main(const int argc, char* argv[]) {
             break;
         }
 
-        bool force = false;
+        if (command == "stats") {
+            std::cout << aw.aggregates.snapshot();
+            continue;
+        }
+
         if (command == "force") {
-            if (count == 0) {
+            if (publisher.pending() == 0) {
                 std::cout << "Nothing to commit." << std::endl;
                 continue;
             }
-            force = true;
-        }
-        else {
-            std::shared_ptr<oop::serializable> fig;
-            if (command == "rhombus") {
-                auto r = new rhombus;
-                read_rhombus(std::cin, *r);
-                fig.reset(r);
-            }
-            else if (command == "pentagon") {
-                fig.reset(new pentagon{ std::cin });
-            }
-            else if (command == "hexagon") {
-                fig.reset(new hexagon{ std::cin });
-            }
-            else {
-                std::cout << "Unknown figure type or command." << std::endl;
-                continue;
-            }
-            std::shared_ptr<const oop::event> e{ new my_event(fig) };
-            publisher.push(e);
-            ++count;
+            publisher.commit();
+            continue;
         }
 
-        if (count == limit || force) {
-            fw.new_unique_file();
-            publisher.commit();
-            count = 0;
+        // Publisher commits by itself when limit is reached or figures get old
+        auto fig = read_figure(command, std::cin);
+        if (!fig) {
+            std::cout << "Unknown figure type or command." << std::endl;
+            continue;
         }
+        std::shared_ptr<const oop::event> e{ new my_event(fig) };
+        publisher.push(e);
     }
 }
 
@@ -178,7 +80,7 @@ size_t parse_limit(const int argc, char* argv[]) {
     if (argc == 1) {
         return default_limit;
     }
-    if (argc > 2) {
+    if (argc > 3) {
         return error_occured;
     }
 
@@ -190,23 +92,3 @@ size_t parse_limit(const int argc, char* argv[]) {
 
     return lim;
 }
-
-void read_rhombus(std::istream& in, rhombus& r) {
-    auto constexpr precision = 0.000000001L;
-    for (auto& p : r) {
-        in >> p;
-    }
-    if (in.fail()) {
-        return;
-    }
-
-    constexpr size_t size = rhombus::size();
-    const double dist     = distance(r[0], r[size - 1]);
-    for (size_t i = 0; i < size - 1; i++) {
-        const double next = distance(r[i], r[i + 1]);
-        if (std::abs(dist - next) > precision) {
-            in.setstate(std::ios::failbit);
-            break;
-        }
-    }
-}
@@ -0,0 +1,395 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <algorithm>
+#include <optional>
+
+#include "app.hpp"
+
+using clock_type = std::chrono::steady_clock;
+
+auto constexpr shm_name = "/oop_exercise_08_bench";
+
+struct options {
+    unsigned long long       seed      = 1;
+    double                   rate      = 0; // figures per second, 0 is unlimited
+    size_t                   figures   = 100000;
+    size_t                   producers = 1;
+    size_t                   commit    = 64; // figures per explicit commit, 0 is none
+    double                   deadline  = 0;  // commit deadline in microseconds, 0 is none
+    oop::commit_policy       policy;
+    std::vector<std::string> subscribers{ "stream", "file" };
+    bool                     console   = false;
+};
+
+/*
+    Stream buffer that drops everything,
+    used to format figures without console overhead
+*/
+struct null_buffer final
+    : std::streambuf {
+protected:
+    int_type overflow(const int_type c) override {
+        return traits_type::not_eof(c);
+    }
+
+    std::streamsize xsputn(const char_type*, const std::streamsize n) override {
+        return n;
+    }
+};
+
+/*
+    Records push -> delivery latency of every event in microseconds,
+    subscribed last so batch is delivered to all other subscribers by then
+*/
+struct latency_recorder final
+    : oop::subscriber {
+    std::vector<double> latencies;
+
+private:
+    void handle(const oop::event& e) override {
+        const auto& my_e = dynamic_cast<const my_event&>(e);
+        const std::chrono::duration<double, std::micro> elapsed = clock_type::now() - my_e.created;
+        latencies.push_back(elapsed.count());
+    }
+};
+
+bool auto_commit_enabled(const oop::commit_policy& policy) {
+    return policy.events != 0 || policy.bytes != 0 || policy.delay.count() != 0;
+}
+
+/*
+    Shared state of benchmark run
+*/
+struct harness {
+    explicit harness(const options& opts)
+        : opts(opts)
+        , null_stream(&null_buf)
+        , publisher(opts.policy) {
+        for (const auto& name : opts.subscribers) {
+            if (name == "stream") {
+                sw = std::make_unique<stream_writer>(opts.console ? std::cout : null_stream);
+                publisher.subscribe(sw.get(), oop::priority::interactive);
+            }
+            else if (name == "file") {
+                fw = std::make_unique<unique_file_writer>();
+                publisher.subscribe(fw.get(), oop::priority::bulk);
+            }
+            else if (name == "aggregates") {
+                aw = std::make_unique<aggregates_writer>();
+                publisher.subscribe(aw.get());
+            }
+            else if (name == "shm") {
+                shw = std::make_unique<shm_writer>(shm_name);
+                publisher.subscribe(shw.get());
+            }
+            else {
+                throw std::invalid_argument("unknown subscriber: " + name);
+            }
+        }
+
+        // Explicit commits do not show delay of auto-committed events
+        if (auto_commit_enabled(opts.policy)) {
+            lr = std::make_unique<latency_recorder>();
+            publisher.subscribe(lr.get(), oop::priority::bulk);
+        }
+    }
+
+    /*!
+     * @brief Commit pending events and measure latency.
+     *
+     * @param latencies
+     * receives commit latency in microseconds
+     */
+    void commit(std::vector<double>& latencies) {
+        const auto start = clock_type::now();
+
+        std::optional<clock_type::time_point> deadline;
+        if (opts.deadline > 0) {
+            deadline = start + std::chrono::duration_cast<clock_type::duration>(
+                std::chrono::duration<double, std::micro>(opts.deadline));
+        }
+
+        const auto report = publisher.commit(deadline);
+        const std::chrono::duration<double, std::micro> elapsed = clock_type::now() - start;
+        latencies.push_back(elapsed.count());
+
+        if (report.deadline_missed()) {
+            ++missed;
+            if (sw && report.missed.front() == sw.get()) {
+                ++console_missed;
+            }
+        }
+    }
+
+    const options& opts;
+
+    null_buffer  null_buf;
+    std::ostream null_stream;
+
+    std::unique_ptr<stream_writer>      sw;
+    std::unique_ptr<unique_file_writer> fw;
+    std::unique_ptr<aggregates_writer>  aw;
+    std::unique_ptr<shm_writer>         shw;
+    std::unique_ptr<latency_recorder>   lr;
+
+    oop::publisher      publisher;
+    std::atomic<size_t> rejected{ 0 };
+    std::atomic<size_t> missed{ 0 };         // commits with any subscriber late
+    std::atomic<size_t> console_missed{ 0 }; // commits with stream writer late
+};
+
+bool parse_options(int argc, char* argv[], options& opts);
+std::string generate_commands(std::mt19937_64& rng, size_t count);
+void produce(harness& h, const std::string& commands, double rate, clock_type::time_point start,
+             std::vector<double>& latencies);
+double percentile(const std::vector<double>& sorted, double q);
+
+int main(const int argc, char* argv[]) {
+    options opts;
+    if (!parse_options(argc, argv, opts)) {
+        std::cout << "Usage: " << argv[0] << " [--seed N] [--rate FIGURES_PER_SEC] [--figures N]\n"
+                     "       [--producers N] [--commit N] [--deadline US]\n"
+                     "       [--auto-events N] [--auto-bytes B] [--auto-delay MS]\n"
+                     "       [--subscribers stream,file,aggregates,shm] [--console]" << std::endl;
+        return 1;
+    }
+
+    // Generate input before measurement so only parse -> push -> commit is timed
+    std::vector<std::string> commands(opts.producers);
+    for (size_t i = 0; i < opts.producers; i++) {
+        std::mt19937_64 rng(opts.seed + i);
+        const size_t    count = opts.figures / opts.producers + (i < opts.figures % opts.producers ? 1 : 0);
+        commands[i] = generate_commands(rng, count);
+    }
+
+    harness h(opts);
+    if (h.fw) {
+        std::cout << "Unique name: " << h.fw->get_unique() << std::endl;
+    }
+
+    std::vector<std::vector<double>> latencies(opts.producers);
+    std::vector<std::thread>         producers;
+    const double rate  = opts.rate / static_cast<double>(opts.producers);
+    const auto   start = clock_type::now();
+    for (size_t i = 0; i < opts.producers; i++) {
+        producers.emplace_back(produce, std::ref(h), std::cref(commands[i]), rate, start, std::ref(latencies[i]));
+    }
+    for (auto& p : producers) {
+        p.join();
+    }
+    const std::chrono::duration<double> elapsed = clock_type::now() - start;
+
+    std::vector<double> all;
+    for (const auto& l : latencies) {
+        all.insert(all.end(), l.begin(), l.end());
+    }
+    std::sort(all.begin(), all.end());
+
+    const auto figures = opts.figures - h.rejected;
+    std::cout << std::fixed << std::setprecision(1)
+              << "seed:        " << opts.seed << "\n"
+              << "figures:     " << figures << " (" << h.rejected << " rejected)\n"
+              << "producers:   " << opts.producers << "\n"
+              << "commit size: " << opts.commit << "\n"
+              << "commits:     " << all.size() << "\n"
+              << "elapsed:     " << elapsed.count() << " s\n"
+              << "throughput:  " << static_cast<double>(figures) / elapsed.count() << " figures/s\n"
+              << "commit latency, us:\n"
+              << "  p50  " << percentile(all, 0.50) << "\n"
+              << "  p99  " << percentile(all, 0.99) << "\n"
+              << "  p999 " << percentile(all, 0.999) << "\n"
+              << "  max  " << (all.empty() ? 0 : all.back()) << std::endl;
+    if (h.lr) {
+        // Producers are joined after their final commits, so every event is delivered
+        auto& delivery = h.lr->latencies;
+        std::sort(delivery.begin(), delivery.end());
+        std::cout << "push -> delivery latency, us:\n"
+                  << "  p50  " << percentile(delivery, 0.50) << "\n"
+                  << "  p99  " << percentile(delivery, 0.99) << "\n"
+                  << "  p999 " << percentile(delivery, 0.999) << "\n"
+                  << "  max  " << (delivery.empty() ? 0 : delivery.back()) << std::endl;
+    }
+    if (opts.deadline > 0) {
+        std::cout << "deadline misses: " << h.missed << " commits ("
+                  << h.console_missed << " with console late)" << std::endl;
+    }
+
+    if (h.aw) {
+        std::cout << h.aw->aggregates.snapshot();
+    }
+}
+
+bool parse_options(const int argc, char* argv[], options& opts) {
+    for (int i = 1; i < argc; i++) {
+        const std::string name = argv[i];
+        if (name == "--console") {
+            opts.console = true;
+            continue;
+        }
+        if (i + 1 == argc) {
+            return false;
+        }
+
+        std::istringstream value(argv[++i]);
+        if (name == "--seed") {
+            value >> opts.seed;
+        }
+        else if (name == "--rate") {
+            value >> opts.rate;
+        }
+        else if (name == "--figures") {
+            value >> opts.figures;
+        }
+        else if (name == "--producers") {
+            value >> opts.producers;
+        }
+        else if (name == "--commit") {
+            value >> opts.commit;
+        }
+        else if (name == "--deadline") {
+            value >> opts.deadline;
+        }
+        else if (name == "--auto-events") {
+            value >> opts.policy.events;
+        }
+        else if (name == "--auto-bytes") {
+            value >> opts.policy.bytes;
+        }
+        else if (name == "--auto-delay") {
+            long long delay = 0;
+            value >> delay;
+            opts.policy.delay = std::chrono::milliseconds(delay);
+        }
+        else if (name == "--subscribers") {
+            opts.subscribers.clear();
+            std::string subscriber;
+            while (std::getline(value, subscriber, ',')) {
+                opts.subscribers.push_back(subscriber);
+            }
+            continue;
+        }
+        else {
+            return false;
+        }
+        if (value.fail()) {
+            return false;
+        }
+    }
+
+    return opts.producers != 0 && opts.rate >= 0 && opts.deadline >= 0 && opts.policy.delay.count() >= 0;
+}
+
+/*!
+ * @brief Generate valid figure commands.
+ *
+ * Figures are regular polygons and rhombi with random center, size and rotation.
+ */
+std::string generate_commands(std::mt19937_64& rng, const size_t count) {
+    const double pi = std::acos(-1.0);
+
+    std::uniform_int_distribution<size_t> type(0, 2);
+    std::uniform_real_distribution<>      center(-100, 100);
+    std::uniform_real_distribution<>      size(1, 50);
+    std::uniform_real_distribution<>      angle(0, 2 * pi);
+
+    std::ostringstream out;
+    out << std::setprecision(17);
+
+    const auto write_point = [&](const point2d& c, const double r, const double a) {
+        out << ' ' << c[0] + r * std::cos(a) << ' ' << c[1] + r * std::sin(a);
+    };
+
+    for (size_t i = 0; i < count; i++) {
+        const point2d c{ center(rng), center(rng) };
+        const double  a = angle(rng);
+        switch (type(rng)) {
+        case 0: {
+            // Diagonals of rhombus are perpendicular and bisect each other
+            const double d1 = size(rng);
+            const double d2 = size(rng);
+            out << "rhombus";
+            write_point(c, d1, a);
+            write_point(c, d2, a + pi / 2);
+            write_point(c, d1, a + pi);
+            write_point(c, d2, a + 3 * pi / 2);
+            break;
+        }
+        case 1: {
+            const double r = size(rng);
+            out << "pentagon";
+            for (size_t k = 0; k < pentagon::size(); k++) {
+                write_point(c, r, a + 2 * pi * k / pentagon::size());
+            }
+            break;
+        }
+        default: {
+            const double r = size(rng);
+            out << "hexagon";
+            for (size_t k = 0; k < hexagon::size(); k++) {
+                write_point(c, r, a + 2 * pi * k / hexagon::size());
+            }
+        }
+        }
+        out << '\n';
+    }
+
+    return out.str();
+}
+
+void produce(harness& h, const std::string& commands, const double rate, const clock_type::time_point start,
+             std::vector<double>& latencies) {
+    using duration = clock_type::duration;
+
+    const auto period = rate > 0
+        ? std::chrono::duration_cast<duration>(std::chrono::duration<double>(1 / rate))
+        : duration::zero();
+    auto   next    = start;
+    size_t pending = 0;
+
+    std::istringstream in(commands);
+    std::string        command;
+    while (in >> command) {
+        if (rate > 0) {
+            std::this_thread::sleep_until(next);
+            next += period;
+        }
+
+        const auto fig = read_figure(command, in);
+        if (!fig || in.fail()) {
+            ++h.rejected;
+            in.clear();
+            std::getline(in, command);
+            continue;
+        }
+
+        h.publisher.push(std::make_shared<my_event>(fig));
+        if (++pending == h.opts.commit) {
+            h.commit(latencies);
+            pending = 0;
+        }
+    }
+
+    if (pending != 0) {
+        h.commit(latencies);
+    }
+}
+
+/*!
+ * @brief Nearest-rank percentile of sorted samples.
+ */
+double percentile(const std::vector<double>& sorted, const double q) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    const auto rank = static_cast<size_t>(std::ceil(q * static_cast<double>(sorted.size())));
+    return sorted[std::min(std::max<size_t>(rank, 1), sorted.size()) - 1];
+}
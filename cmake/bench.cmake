@@ -0,0 +1,3 @@
+set(Bench ${ProjectName}_bench)
+verbose_log(MESSAGE "Load generator name: " ${Bench})
+add_subdirectory(bench)
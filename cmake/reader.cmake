@@ -0,0 +1,3 @@
+set(Reader ${ProjectName}_reader)
+verbose_log(MESSAGE "Shared memory reader name: " ${Reader})
+add_subdirectory(reader)
@@ -0,0 +1,8 @@
+# Sanitizer configuration
+# Use separate build directory for each sanitizer, e.g. -DSANITIZER=thread
+set(SANITIZER "" CACHE STRING "Sanitizer to build with (address, thread, undefined)")
+if(SANITIZER)
+    set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -fsanitize=${SANITIZER} -fno-omit-frame-pointer -g")
+    set(CMAKE_EXE_LINKER_FLAGS "${CMAKE_EXE_LINKER_FLAGS} -fsanitize=${SANITIZER}")
+    verbose_log(MESSAGE "Sanitizer: " ${SANITIZER})
+endif()
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef> // size_t
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+#include <point.hpp>
+#include <polygon.hpp>
+
+namespace oop {
+    /*!
+     * @brief Streaming estimator of a single quantile.
+     *
+     * Implements P-square algorithm (Jain & Chlamtac): keeps five markers
+     * only, so memory does not depend on the number of observations.
+     */
+    class p2_quantile final {
+    public:
+        explicit p2_quantile(double p);
+
+        void add(double x);
+        void reset() noexcept;
+
+        [[nodiscard]] double value() const;
+        [[nodiscard]] size_t count() const noexcept {
+            return count_;
+        }
+
+    private:
+        static size_t constexpr markers = 5;
+
+        double p_;
+        size_t count_;
+        double heights_[markers];    // marker heights (quantile estimations)
+        double positions_[markers];  // actual marker positions
+        double desired_[markers];    // desired marker positions
+        double increments_[markers]; // desired positions increments
+
+        [[nodiscard]] double parabolic(size_t i, double d) const;
+        [[nodiscard]] double linear(size_t i, double d) const;
+    };
+
+    struct bounding_box {
+        point2d min;
+        point2d max;
+    };
+
+    /*!
+     * @brief Aggregates over some set of figures.
+     */
+    struct aggregates_summary {
+        size_t                        count      = 0;
+        std::map<std::string, size_t> types;
+        double                        total_area = 0;
+        double                        mean_area  = 0;
+        bounding_box                  box        = {};
+        double                        p50_area   = 0;
+        double                        p90_area   = 0;
+        double                        p99_area   = 0;
+    };
+
+    struct aggregates_snapshot {
+        aggregates_summary batch; // last (or current) commit only
+        aggregates_summary total; // whole run
+    };
+
+    std::ostream& operator<<(std::ostream& stream, const aggregates_summary& summary);
+    std::ostream& operator<<(std::ostream& stream, const aggregates_snapshot& snapshot);
+
+    /*!
+     * @brief Running totals over figures.
+     *
+     * Thread-safe: figures are added from the publisher routine while
+     * snapshots are taken from any other thread. Uses constant memory.
+     */
+    class aggregates final {
+    public:
+        aggregates() = default;
+
+        aggregates(const aggregates&)                = delete;
+        aggregates(aggregates&&) noexcept            = delete;
+        aggregates& operator=(const aggregates&)     = delete;
+        aggregates& operator=(aggregates&&) noexcept = delete;
+
+        /*!
+         * @brief Add next figure.
+         *
+         * @param polygon
+         * figure to account
+         */
+        template<size_t _NumOfPoints>
+        void add(const basic_polygon<point2d, _NumOfPoints>& polygon) {
+            bounding_box box{ polygon[0], polygon[0] };
+            for (const auto& p : polygon) {
+                for (size_t i = 0; i < p.size(); i++) {
+                    box.min[i] = std::min(box.min[i], p[i]);
+                    box.max[i] = std::max(box.max[i], p[i]);
+                }
+            }
+            add(polygon_name(_NumOfPoints), area2d(polygon), box);
+        }
+
+        void add(const std::string& type, double area, const bounding_box& box);
+
+        /*!
+         * @brief Start new batch.
+         *
+         * Batch aggregates are reset, total ones are kept.
+         */
+        void new_batch();
+
+        [[nodiscard]] aggregates_snapshot snapshot() const;
+
+    private:
+        class accumulator final {
+        public:
+            accumulator();
+
+            void add(const std::string& type, double area, const bounding_box& box);
+            void reset();
+
+            [[nodiscard]] aggregates_summary summary() const;
+
+        private:
+            aggregates_summary summary_;
+            p2_quantile        p50_;
+            p2_quantile        p90_;
+            p2_quantile        p99_;
+        };
+
+        mutable std::mutex mu_;
+        accumulator        batch_;
+        accumulator        total_;
+    };
+}
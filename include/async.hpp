@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef> // size_t
+
 namespace oop {
     struct event {
         event()                            = default;
@@ -9,5 +11,13 @@ namespace oop {
         event& operator=(event&&) noexcept = default;
 
         virtual ~event() = 0;
+
+        /*!
+         * @brief Event payload size in bytes, used by auto-commit policy.
+         *
+         * @return
+         * 0 if size is unknown
+         */
+        [[nodiscard]] virtual size_t size() const noexcept { return 0; }
     };
 }
\ No newline at end of file
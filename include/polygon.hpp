@@ -234,24 +234,26 @@ auto center2d(const _T& tuple) {
     return detail::center2d(tuple, std::make_index_sequence<tuple_size>{});
 }
 
-template<typename _T>
-auto print2d(std::ostream& stream, const _T& tuple) {
-    auto constexpr tuple_size = std::tuple_size<_T>{}();
-
-    using std::endl;
-
-    stream << "\ntype:   ";
-    switch (tuple_size) {
+inline const char* polygon_name(size_t num_of_points) noexcept {
+    switch (num_of_points) {
     case 4:
-        stream << "rhombus" << endl; break;
+        return "rhombus";
     case 5:
-        stream << "pentagon" << endl; break;
+        return "pentagon";
     case 6:
-        stream << "hexagon" << endl; break;
+        return "hexagon";
     default:
-        stream << "unknown" << endl;
+        return "unknown";
     }
+}
+
+template<typename _T>
+auto print2d(std::ostream& stream, const _T& tuple) {
+    auto constexpr tuple_size = std::tuple_size<_T>{}();
+
+    using std::endl;
 
+    stream << "\ntype:   " << polygon_name(tuple_size) << endl;
     stream << "center: " << center2d(tuple) << endl
         << "area:   " << area2d(tuple) << endl
         << "points: ";
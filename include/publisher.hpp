@@ -6,15 +6,53 @@
 #include <mutex>
 #include <condition_variable>
 #include <thread>
+#include <chrono>
+#include <optional>
 
 #include <async.hpp>
 
 namespace oop {
     class subscriber;
 
+    /*!
+     * @brief Subscriber priority class.
+     *
+     * Higher priority subscribers get the whole committed batch
+     * before lower priority ones.
+     */
+    enum class priority {
+        interactive, // console and other latency-sensitive consumers
+        normal,
+        bulk,        // archival writers
+    };
+
+    /*!
+     * @brief Auto-commit policy.
+     *
+     * Publisher commits by itself when any of limits is reached.
+     * Zero value turns corresponding limit off.
+     */
+    struct commit_policy {
+        size_t                    events = 0; // pending events count
+        size_t                    bytes  = 0; // pending events size, see event::size
+        std::chrono::milliseconds delay{ 0 }; // age of the oldest pending event
+    };
+
+    /*!
+     * @brief Result of single commit.
+     */
+    struct commit_report {
+        // Subscribers which got the batch after the commit deadline
+        std::vector<const subscriber*> missed;
+
+        [[nodiscard]] bool deadline_missed() const noexcept {
+            return !missed.empty();
+        }
+    };
+
     class publisher final {
     public:
-        publisher();
+        explicit publisher(const commit_policy& policy = {});
         ~publisher();
 
         publisher(const publisher&)                = delete;
@@ -30,33 +68,72 @@ namespace oop {
          */
         void push(const std::shared_ptr<const event>& e);
 
+        /*!
+         * @brief Number of pushed but not committed events.
+         */
+        [[nodiscard]] size_t pending() const;
+
+        using clock_type = std::chrono::steady_clock;
+
         /*!
          * @brief Commit current events queue.
          *
          * Function does NOT RETURN till committing is not complete.
+         * May be called from several threads at once.
+         *
+         * @param deadline
+         * time point every subscriber should get the batch by
+         *
+         * @return
+         * subscribers that missed the deadline
          */
-        void commit();
+        commit_report commit(std::optional<clock_type::time_point> deadline = std::nullopt);
 
         /*!
          * @brief Add new subscriber.
          *
+         * Subscribers of the same priority are served in registration order.
+         *
          * @param s
          * pointer to new subscriber
+         *
+         * @param p
+         * priority class of subscriber
          */
-        void subscribe(subscriber* s);
+        void subscribe(subscriber* s, priority p = priority::normal);
 
     private:
-        std::mutex              publisher_mu_;
+        struct subscription {
+            priority    prio;
+            subscriber* s;
+        };
+
+        struct commit_request {
+            std::optional<clock_type::time_point> deadline;
+            commit_report                         report;
+            bool                                  done = false;
+        };
+
         std::condition_variable publisher_cv_;
 
         std::vector<std::shared_ptr<const event>> events_;
+        std::vector<commit_request*>              commits_; // waiting commit callers
 
-        std::list<subscriber*>    subscribers_;
+        const commit_policy    policy_;
+        size_t                 pending_bytes_;
+        clock_type::time_point oldest_; // push time of the first pending event
+
+        std::list<subscription>   subscribers_; // sorted by priority
         std::thread               routine_;
-        std::mutex                routine_mu_;
+        mutable std::mutex        routine_mu_;
         std::condition_variable   routine_cv_;
         bool                      events_done_;
 
+        [[nodiscard]] bool auto_commit_enabled() const noexcept;
+        [[nodiscard]] bool limit_reached() const noexcept;
+        [[nodiscard]] bool auto_commit_due() const;
+
+        void dispatch(std::unique_lock<std::mutex>& lock);
         void routine_proc();
         void stop_routine();
     };
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstddef> // size_t
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <type_traits>
+
+#include <point.hpp>
+#include <polygon.hpp>
+
+namespace oop {
+    /*!
+     * @brief Binary form of figure stored in shared memory.
+     */
+    struct figure_record {
+        static size_t constexpr max_vertices = 8;
+
+        std::uint32_t vertices;
+        std::uint32_t reserved;
+        point2d       points[max_vertices];
+    };
+    static_assert(std::is_trivially_copyable_v<figure_record>, "figure_record must be trivially copyable");
+
+    template<size_t _NumOfPoints>
+    figure_record make_figure_record(const basic_polygon<point2d, _NumOfPoints>& polygon) {
+        static_assert(_NumOfPoints <= figure_record::max_vertices, "polygon does not fit figure_record");
+
+        figure_record record{};
+        record.vertices = static_cast<std::uint32_t>(_NumOfPoints);
+        std::copy(polygon.begin(), polygon.end(), record.points);
+        return record;
+    }
+
+    // Layout of shared memory segment, see shm_transport.cpp
+    struct shm_layout;
+
+    /*!
+     * @brief Writer side of shared memory ring buffer.
+     *
+     * Creates POSIX shared memory segment `name` and writes figure records
+     * into it. Readers in other processes attach with shm_reader.
+     * Segment left by dead writer is replaced, segment of live writer is not.
+     */
+    class shm_transport final {
+    public:
+        static size_t constexpr max_readers = 16;
+
+        /*!
+         * @param name
+         * name of segment as for shm_open, e.g. "/figures"
+         *
+         * @param capacity
+         * number of records in ring
+         *
+         * @param stall_timeout
+         * how long reader may make no progress before it is detached, zero waits forever
+         */
+        explicit shm_transport(const std::string& name, size_t capacity = 1024,
+                               std::chrono::milliseconds stall_timeout = std::chrono::seconds(1));
+        ~shm_transport();
+
+        shm_transport(const shm_transport&)                = delete;
+        shm_transport(shm_transport&&) noexcept            = delete;
+        shm_transport& operator=(const shm_transport&)     = delete;
+        shm_transport& operator=(shm_transport&&) noexcept = delete;
+
+        /*!
+         * @brief Write next record.
+         *
+         * Record is not visible to readers till flush. Function blocks
+         * while ring is full of records some attached reader has not read yet.
+         */
+        void write(const figure_record& r);
+
+        /*!
+         * @brief Publish written records.
+         *
+         * Function does NOT RETURN till every attached reader consumes them.
+         * Readers whose process is dead are detached. Readers that consume
+         * nothing for stall_timeout (e.g. stopped process) are detached too.
+         */
+        void flush();
+
+    private:
+        std::string   name_;
+        size_t                    capacity_;
+        std::chrono::milliseconds stall_timeout_;
+        size_t                    size_;
+        shm_layout*               layout_;
+        std::uint64_t             written_;
+
+        void publish();
+        void wait_readers(std::uint64_t position);
+    };
+
+    /*!
+     * @brief Reader side of shared memory ring buffer.
+     *
+     * Every reader has its own cursor. Records are read in place.
+     */
+    class shm_reader final {
+    public:
+        explicit shm_reader(const std::string& name);
+        ~shm_reader();
+
+        shm_reader(const shm_reader&)                = delete;
+        shm_reader(shm_reader&&) noexcept            = delete;
+        shm_reader& operator=(const shm_reader&)     = delete;
+        shm_reader& operator=(shm_reader&&) noexcept = delete;
+
+        /*!
+         * @brief Number of published records not consumed yet.
+         */
+        [[nodiscard]] size_t available() const;
+
+        /*!
+         * @brief Access available record without copying.
+         *
+         * @param ix
+         * index in [0, available())
+         */
+        [[nodiscard]] const figure_record& at(size_t ix) const;
+
+        /*!
+         * @brief Mark first n available records as consumed.
+         */
+        void consume(size_t n);
+
+        /*!
+         * @brief Check whether writer is gone (closed segment or died).
+         */
+        [[nodiscard]] bool closed() const;
+
+        /*!
+         * @brief Check whether writer detached this reader for stalling.
+         *
+         * Detached reader gets no more records, its cursor is not tracked.
+         */
+        [[nodiscard]] bool detached() const;
+
+    private:
+        size_t        size_;
+        shm_layout*   layout_;
+        size_t        slot_;
+        std::uint64_t cursor_;
+    };
+}
@@ -16,6 +16,8 @@ namespace oop {
     private:
         virtual bool is_suitable(const event& e) { return true; }
         virtual void handle(const event& e) = 0;
+        // Called after the whole committed batch is handled
+        virtual void flush() {}
 
         friend class publisher;
     };
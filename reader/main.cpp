@@ -0,0 +1,67 @@
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include <point.hpp>
+#include <polygon.hpp>
+#include <shm_transport.hpp>
+
+auto constexpr poll_interval = std::chrono::milliseconds(1);
+
+void print_record(std::ostream& stream, const oop::figure_record& record);
+
+int main(const int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cout << "Usage: " << argv[0] << " SHARED_MEMORY_NAME" << std::endl;
+        return 1;
+    }
+
+    try {
+        oop::shm_reader reader(argv[1]);
+        while (true) {
+            if (reader.detached()) {
+                throw std::runtime_error("reader is too slow and was detached by writer");
+            }
+
+            const auto n = reader.available();
+            if (n == 0) {
+                if (reader.closed()) {
+                    break;
+                }
+                std::this_thread::sleep_for(poll_interval);
+                continue;
+            }
+
+            for (size_t i = 0; i < n; i++) {
+                print_record(std::cout, reader.at(i));
+            }
+            reader.consume(n);
+        }
+    }
+    catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+template<size_t _NumOfPoints>
+void print_polygon(std::ostream& stream, const oop::figure_record& record) {
+    basic_polygon<point2d, _NumOfPoints> polygon;
+    std::copy_n(record.points, _NumOfPoints, polygon.begin());
+    polygon.write(stream);
+}
+
+void print_record(std::ostream& stream, const oop::figure_record& record) {
+    switch (record.vertices) {
+    case 4:
+        print_polygon<4>(stream, record); break;
+    case 5:
+        print_polygon<5>(stream, record); break;
+    case 6:
+        print_polygon<6>(stream, record); break;
+    default:
+        stream << "\ntype:   unknown" << std::endl;
+    }
+}
@@ -0,0 +1,203 @@
+#include "aggregates.hpp"
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+using namespace oop;
+
+p2_quantile::p2_quantile(const double p)
+    : p_{ p }
+    , count_{ 0 }
+    , heights_{}
+    , positions_{}
+    , desired_{}
+    , increments_{} {
+    if (p <= 0 || p >= 1) {
+        throw std::invalid_argument("p2_quantile: p must be in (0, 1)");
+    }
+}
+
+void p2_quantile::add(const double x) {
+    // Collect first observations as is
+    if (count_ < markers) {
+        heights_[count_++] = x;
+        if (count_ == markers) {
+            std::sort(std::begin(heights_), std::end(heights_));
+            for (size_t i = 0; i < markers; i++) {
+                positions_[i] = static_cast<double>(i);
+            }
+            desired_[0]    = 0;
+            desired_[1]    = 2 * p_;
+            desired_[2]    = 4 * p_;
+            desired_[3]    = 2 + 2 * p_;
+            desired_[4]    = 4;
+            increments_[0] = 0;
+            increments_[1] = p_ / 2;
+            increments_[2] = p_;
+            increments_[3] = (1 + p_) / 2;
+            increments_[4] = 1;
+        }
+        return;
+    }
+
+    // Find cell k such that heights_[k] <= x < heights_[k + 1]
+    size_t k;
+    if (x < heights_[0]) {
+        heights_[0] = x;
+        k           = 0;
+    }
+    else if (x >= heights_[markers - 1]) {
+        heights_[markers - 1] = x;
+        k                     = markers - 2;
+    }
+    else {
+        k = 1;
+        while (x >= heights_[k]) {
+            ++k;
+        }
+        --k;
+    }
+
+    for (size_t i = k + 1; i < markers; i++) {
+        positions_[i] += 1;
+    }
+    for (size_t i = 0; i < markers; i++) {
+        desired_[i] += increments_[i];
+    }
+    ++count_;
+
+    // Adjust inner markers
+    for (size_t i = 1; i < markers - 1; i++) {
+        const double d = desired_[i] - positions_[i];
+        if ((d >= 1 && positions_[i + 1] - positions_[i] > 1) ||
+            (d <= -1 && positions_[i - 1] - positions_[i] < -1)) {
+            const double sign = d > 0 ? 1 : -1;
+            const double h    = parabolic(i, sign);
+            if (heights_[i - 1] < h && h < heights_[i + 1]) {
+                heights_[i] = h;
+            }
+            else {
+                heights_[i] = linear(i, sign);
+            }
+            positions_[i] += sign;
+        }
+    }
+}
+
+void p2_quantile::reset() noexcept {
+    count_ = 0;
+}
+
+double p2_quantile::value() const {
+    if (count_ == 0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    if (count_ < markers) {
+        double sorted[markers];
+        std::copy_n(heights_, count_, sorted);
+        std::sort(sorted, sorted + count_);
+        const auto ix = static_cast<size_t>(std::round(p_ * static_cast<double>(count_ - 1)));
+        return sorted[ix];
+    }
+    return heights_[2];
+}
+
+double p2_quantile::parabolic(const size_t i, const double d) const {
+    const double* q = heights_;
+    const double* n = positions_;
+    return q[i] + d / (n[i + 1] - n[i - 1]) *
+        ((n[i] - n[i - 1] + d) * (q[i + 1] - q[i]) / (n[i + 1] - n[i]) +
+         (n[i + 1] - n[i] - d) * (q[i] - q[i - 1]) / (n[i] - n[i - 1]));
+}
+
+double p2_quantile::linear(const size_t i, const double d) const {
+    const size_t j = d > 0 ? i + 1 : i - 1;
+    return heights_[i] + d * (heights_[j] - heights_[i]) / (positions_[j] - positions_[i]);
+}
+
+aggregates::accumulator::accumulator()
+    : p50_{ 0.50 }
+    , p90_{ 0.90 }
+    , p99_{ 0.99 } {}
+
+void aggregates::accumulator::add(const std::string& type, const double area, const bounding_box& box) {
+    if (summary_.count == 0) {
+        summary_.box = box;
+    }
+    else {
+        for (size_t i = 0; i < point2d::size(); i++) {
+            summary_.box.min[i] = std::min(summary_.box.min[i], box.min[i]);
+            summary_.box.max[i] = std::max(summary_.box.max[i], box.max[i]);
+        }
+    }
+
+    ++summary_.count;
+    ++summary_.types[type];
+    summary_.total_area += area;
+
+    p50_.add(area);
+    p90_.add(area);
+    p99_.add(area);
+}
+
+void aggregates::accumulator::reset() {
+    summary_ = {};
+    p50_.reset();
+    p90_.reset();
+    p99_.reset();
+}
+
+aggregates_summary aggregates::accumulator::summary() const {
+    auto result = summary_;
+    if (result.count != 0) {
+        result.mean_area = result.total_area / static_cast<double>(result.count);
+        result.p50_area  = p50_.value();
+        result.p90_area  = p90_.value();
+        result.p99_area  = p99_.value();
+    }
+    return result;
+}
+
+void aggregates::add(const std::string& type, const double area, const bounding_box& box) {
+    std::lock_guard lock(mu_);
+    batch_.add(type, area, box);
+    total_.add(type, area, box);
+}
+
+void aggregates::new_batch() {
+    std::lock_guard lock(mu_);
+    batch_.reset();
+}
+
+aggregates_snapshot aggregates::snapshot() const {
+    std::lock_guard lock(mu_);
+    return { batch_.summary(), total_.summary() };
+}
+
+std::ostream& oop::operator<<(std::ostream& stream, const aggregates_summary& summary) {
+    using std::endl;
+
+    stream << "count:  " << summary.count << endl;
+    for (const auto& [type, count] : summary.types) {
+        stream << "  " << type << ": " << count << endl;
+    }
+    if (summary.count == 0) {
+        return stream;
+    }
+    stream << "area:   total " << summary.total_area
+           << ", mean " << summary.mean_area
+           << ", p50 " << summary.p50_area
+           << ", p90 " << summary.p90_area
+           << ", p99 " << summary.p99_area << endl
+           << "box:    " << summary.box.min << summary.box.max << endl;
+
+    return stream;
+}
+
+std::ostream& oop::operator<<(std::ostream& stream, const aggregates_snapshot& snapshot) {
+    stream << "\n[batch]\n" << snapshot.batch
+           << "[total]\n" << snapshot.total << std::endl;
+
+    return stream;
+}
@@ -1,5 +1,6 @@
 #include "publisher.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <stdexcept>
 
@@ -11,11 +12,11 @@ using namespace oop;
  * @brief
  * Initializes new routine (sub-thread), sets events_done_ to false.
  */
-publisher::publisher() try
-    : events_done_{ false } {
-    std::unique_lock publisher_lock(routine_mu_);
+publisher::publisher(const commit_policy& policy) try
+    : policy_{ policy }
+    , pending_bytes_{ 0 }
+    , events_done_{ false } {
     routine_ = std::thread(&publisher::routine_proc, this);
-    publisher_cv_.wait(publisher_lock);
 }
 catch (...) {
     throw std::runtime_error("publisher: can not create thread");
@@ -27,47 +28,125 @@ publisher::~publisher() {
 
 void publisher::push(const std::shared_ptr<const event>& e) {
     std::lock_guard lock(routine_mu_);
+    const bool first = events_.empty();
+    if (first && policy_.delay.count() != 0) {
+        oldest_ = clock_type::now();
+    }
     events_.push_back(e);
-}
+    pending_bytes_ += e->size();
 
-void publisher::commit() {
-    std::unique_lock publisher_lock(publisher_mu_);
-    {
-        std::lock_guard routine_lock(routine_mu_);
-        routine_cv_.notify_all();
+    // Wake routine to commit or to start timer for new batch
+    if (limit_reached() || (first && policy_.delay.count() != 0)) {
+        routine_cv_.notify_one();
     }
-    publisher_cv_.wait(publisher_lock);
 }
 
-void publisher::subscribe(subscriber* s) {
+size_t publisher::pending() const {
     std::lock_guard lock(routine_mu_);
-    subscribers_.push_back(s);
+    return events_.size();
 }
 
-void publisher::routine_proc() {
+commit_report publisher::commit(const std::optional<clock_type::time_point> deadline) {
     std::unique_lock lock(routine_mu_);
-    publisher_cv_.notify_one();
-
-    while (!events_done_) {
-        // Wait for next events
-        routine_cv_.wait(lock);
-
-        // Lock publisher to force it to wait till loop end
-        std::lock_guard publisher_lock(publisher_mu_);
-
-        // Process events
-        while(!events_.empty()) {
-            auto& e = *events_.back();
-            for (auto s : subscribers_) {
-                if (s->is_suitable(e)) {
-                    s->handle(e);
-                }
+    commit_request   request{ deadline, {}, false };
+    commits_.push_back(&request);
+    routine_cv_.notify_one();
+
+    // Wait till routine serves this commit
+    publisher_cv_.wait(lock, [&] { return request.done; });
+
+    return std::move(request.report);
+}
+
+void publisher::subscribe(subscriber* s, const priority p) {
+    std::lock_guard lock(routine_mu_);
+    const auto pos = std::find_if(subscribers_.begin(), subscribers_.end(),
+                                  [&](const subscription& sub) { return sub.prio > p; });
+    subscribers_.insert(pos, { p, s });
+}
+
+bool publisher::auto_commit_enabled() const noexcept {
+    return policy_.events != 0 || policy_.bytes != 0 || policy_.delay.count() != 0;
+}
+
+bool publisher::limit_reached() const noexcept {
+    return (policy_.events != 0 && events_.size() >= policy_.events) ||
+           (policy_.bytes != 0 && pending_bytes_ >= policy_.bytes);
+}
+
+bool publisher::auto_commit_due() const {
+    if (events_.empty()) {
+        return false;
+    }
+    // Events would be committed anyway, do not lose them on stop
+    if (events_done_ && auto_commit_enabled()) {
+        return true;
+    }
+    return limit_reached() ||
+           (policy_.delay.count() != 0 && clock_type::now() >= oldest_ + policy_.delay);
+}
+
+void publisher::dispatch(std::unique_lock<std::mutex>& lock) {
+    // Every commit requested so far is served by this pass
+    const auto requests = std::move(commits_);
+    commits_.clear();
+
+    const auto events = std::move(events_);
+    events_.clear();
+    pending_bytes_ = 0;
+
+    const std::vector<subscription> subscribers(subscribers_.begin(), subscribers_.end());
+
+    // Deliver without lock: pushes and commits queue for the next pass meanwhile
+    lock.unlock();
+
+    // Process events: each subscriber gets the whole batch
+    // before next (lower priority) one starts
+    for (const auto& [prio, s] : subscribers) {
+        for (auto it = events.rbegin(); it != events.rend(); ++it) {
+            const auto& e = **it;
+            if (s->is_suitable(e)) {
+                s->handle(e);
+            }
+        }
+        s->flush();
+
+        const auto delivered = clock_type::now();
+        for (auto request : requests) {
+            if (request->deadline && delivered > *request->deadline) {
+                request->report.missed.push_back(s);
             }
-            events_.pop_back();
+        }
+    }
+
+    lock.lock();
+
+    // Release committers
+    for (auto request : requests) {
+        request->done = true;
+    }
+    publisher_cv_.notify_all();
+}
+
+void publisher::routine_proc() {
+    std::unique_lock lock(routine_mu_);
+
+    while (true) {
+        if (!commits_.empty() || auto_commit_due()) {
+            dispatch(lock);
+            continue;
+        }
+        if (events_done_) {
+            break;
         }
 
-        // Unlock publisher
-        publisher_cv_.notify_one();
+        // Wait for next commit, or till the oldest pending event expires
+        if (policy_.delay.count() != 0 && !events_.empty()) {
+            routine_cv_.wait_until(lock, oldest_ + policy_.delay);
+        }
+        else {
+            routine_cv_.wait(lock);
+        }
     }
 }
 
@@ -75,7 +154,7 @@ void publisher::stop_routine() {
     // Signal thread to stop
     {
         std::lock_guard lock(routine_mu_);
-        if (!events_.empty()) {
+        if (!events_.empty() && !auto_commit_enabled()) {
             std::terminate();
         }
         events_done_ = true;
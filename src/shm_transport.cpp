@@ -0,0 +1,319 @@
+#include "shm_transport.hpp"
+
+#include <stdexcept>
+
+#ifndef _WIN32
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace oop;
+
+namespace {
+    std::uint32_t constexpr shm_magic     = 0x4f4f5038; // "OOP8"
+    auto constexpr          poll_interval = std::chrono::microseconds(50);
+
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "shared atomics must be lock-free");
+    static_assert(std::atomic<std::int32_t>::is_always_lock_free, "shared atomics must be lock-free");
+
+    struct reader_slot {
+        std::atomic<std::int32_t>  pid;    // 0 is free slot, -pid is attaching reader
+        std::atomic<std::uint64_t> cursor; // records consumed by reader
+    };
+
+    std::runtime_error system_error(const std::string& what) {
+        return std::runtime_error(what + ": " + std::strerror(errno));
+    }
+
+    bool is_alive(const pid_t pid) {
+        return kill(pid, 0) == 0 || errno != ESRCH;
+    }
+}
+
+struct oop::shm_layout {
+    std::atomic<std::uint32_t> magic;     // set last, when segment is ready
+    std::uint32_t              capacity;
+    std::atomic<std::int32_t>  writer;    // writer pid, 0 when closed
+    std::atomic<std::uint64_t> published; // records visible to readers
+
+    reader_slot readers[shm_transport::max_readers];
+
+    figure_record* records() noexcept {
+        return reinterpret_cast<figure_record*>(this + 1);
+    }
+};
+
+namespace {
+    /*
+        Check whether existing segment `name` is ready and its writer is alive
+    */
+    bool writer_alive(const std::string& name) {
+        const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd == -1) {
+            return false;
+        }
+        struct stat st {};
+        if (fstat(fd, &st) == -1 || static_cast<size_t>(st.st_size) < sizeof(shm_layout)) {
+            close(fd);
+            return false;
+        }
+        void* addr = mmap(nullptr, sizeof(shm_layout), PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (addr == MAP_FAILED) {
+            return false;
+        }
+
+        const auto layout = static_cast<const shm_layout*>(addr);
+        const auto writer = layout->magic.load(std::memory_order_acquire) == shm_magic
+            ? layout->writer.load(std::memory_order_acquire)
+            : 0;
+        munmap(addr, sizeof(shm_layout));
+        return writer != 0 && is_alive(writer);
+    }
+}
+
+shm_transport::shm_transport(const std::string& name, const size_t capacity,
+                             const std::chrono::milliseconds stall_timeout)
+    : name_{ name }
+    , capacity_{ capacity }
+    , stall_timeout_{ stall_timeout }
+    , size_{ sizeof(shm_layout) + capacity * sizeof(figure_record) }
+    , layout_{ nullptr }
+    , written_{ 0 } {
+    if (capacity == 0) {
+        throw std::invalid_argument("shm_transport: capacity must not be zero");
+    }
+
+    // Segment may be left by crashed writer, but must not be taken from live one
+    if (writer_alive(name_)) {
+        throw std::runtime_error("shm_transport: segment is owned by live writer");
+    }
+    shm_unlink(name_.c_str());
+
+    const int fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd == -1) {
+        throw system_error("shm_transport: can not create segment");
+    }
+    if (ftruncate(fd, static_cast<off_t>(size_)) == -1) {
+        const auto error = system_error("shm_transport: can not resize segment");
+        close(fd);
+        shm_unlink(name_.c_str());
+        throw error;
+    }
+    void* addr = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        const auto error = system_error("shm_transport: can not map segment");
+        shm_unlink(name_.c_str());
+        throw error;
+    }
+
+    layout_           = new (addr) shm_layout{};
+    layout_->capacity = static_cast<std::uint32_t>(capacity_);
+    layout_->writer.store(getpid());
+    layout_->magic.store(shm_magic, std::memory_order_release);
+}
+
+shm_transport::~shm_transport() {
+    layout_->writer.store(0, std::memory_order_release);
+    munmap(layout_, size_);
+    shm_unlink(name_.c_str());
+}
+
+void shm_transport::write(const figure_record& r) {
+    // Readers attach at published position, so keep unpublished part within ring
+    if (written_ - layout_->published.load(std::memory_order_relaxed) == capacity_) {
+        publish();
+    }
+    if (written_ >= capacity_) {
+        wait_readers(written_ - capacity_ + 1);
+    }
+
+    layout_->records()[written_ % capacity_] = r;
+    ++written_;
+}
+
+void shm_transport::flush() {
+    publish();
+    wait_readers(written_);
+}
+
+void shm_transport::publish() {
+    layout_->published.store(written_, std::memory_order_release);
+}
+
+void shm_transport::wait_readers(const std::uint64_t position) {
+    using clock_type = std::chrono::steady_clock;
+
+    // Last seen state of every slot, reader makes progress when it changes
+    struct progress {
+        std::int32_t           pid    = 0;
+        std::uint64_t          cursor = 0;
+        clock_type::time_point since;
+    } seen[max_readers];
+
+    while (true) {
+        bool       done = true;
+        const auto now  = clock_type::now();
+        for (size_t i = 0; i < max_readers; i++) {
+            auto& slot = layout_->readers[i];
+            auto  pid  = slot.pid.load(std::memory_order_acquire);
+            if (pid == 0) {
+                continue;
+            }
+            // Reader with negative pid is still setting its cursor
+            const auto cursor = slot.cursor.load(std::memory_order_acquire);
+            if (pid > 0 && cursor >= position) {
+                continue;
+            }
+            if (!is_alive(pid < 0 ? -pid : pid)) {
+                slot.pid.compare_exchange_strong(pid, 0);
+                continue;
+            }
+
+            auto& last = seen[i];
+            if (last.pid != pid || last.cursor != cursor) {
+                last = { pid, cursor, now };
+            }
+            else if (stall_timeout_.count() != 0 && now - last.since >= stall_timeout_) {
+                slot.pid.compare_exchange_strong(pid, 0);
+                continue;
+            }
+            done = false;
+        }
+        if (done) {
+            return;
+        }
+        std::this_thread::sleep_for(poll_interval);
+    }
+}
+
+shm_reader::shm_reader(const std::string& name)
+    : size_{ 0 }
+    , layout_{ nullptr }
+    , slot_{ 0 }
+    , cursor_{ 0 } {
+    const int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd == -1) {
+        throw system_error("shm_reader: can not open segment");
+    }
+    struct stat st {};
+    if (fstat(fd, &st) == -1 || static_cast<size_t>(st.st_size) < sizeof(shm_layout)) {
+        close(fd);
+        throw std::runtime_error("shm_reader: segment is not ready");
+    }
+    size_ = static_cast<size_t>(st.st_size);
+
+    void* addr = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        throw system_error("shm_reader: can not map segment");
+    }
+    layout_ = static_cast<shm_layout*>(addr);
+
+    if (layout_->magic.load(std::memory_order_acquire) != shm_magic ||
+        size_ < sizeof(shm_layout) + layout_->capacity * sizeof(figure_record)) {
+        munmap(layout_, size_);
+        throw std::runtime_error("shm_reader: segment is not ready");
+    }
+
+    // Claim free slot as attaching, so writer waits for it or reaps it if we die
+    const std::int32_t pid = getpid();
+    for (slot_ = 0; slot_ < shm_transport::max_readers; slot_++) {
+        auto&        slot = layout_->readers[slot_];
+        std::int32_t free = 0;
+        if (slot.pid.compare_exchange_strong(free, -pid)) {
+            cursor_ = layout_->published.load(std::memory_order_acquire);
+            slot.cursor.store(cursor_, std::memory_order_release);
+            slot.pid.store(pid, std::memory_order_release);
+            return;
+        }
+    }
+
+    munmap(layout_, size_);
+    throw std::runtime_error("shm_reader: no free reader slots");
+}
+
+shm_reader::~shm_reader() {
+    // Slot may be detached and reused by other reader already
+    std::int32_t pid = getpid();
+    layout_->readers[slot_].pid.compare_exchange_strong(pid, 0);
+    munmap(layout_, size_);
+}
+
+size_t shm_reader::available() const {
+    return static_cast<size_t>(layout_->published.load(std::memory_order_acquire) - cursor_);
+}
+
+const figure_record& shm_reader::at(const size_t ix) const {
+    return layout_->records()[(cursor_ + ix) % layout_->capacity];
+}
+
+void shm_reader::consume(const size_t n) {
+    cursor_ += n;
+    if (!detached()) {
+        layout_->readers[slot_].cursor.store(cursor_, std::memory_order_release);
+    }
+}
+
+bool shm_reader::closed() const {
+    const auto writer = layout_->writer.load(std::memory_order_acquire);
+    return writer == 0 || !is_alive(writer);
+}
+
+bool shm_reader::detached() const {
+    return layout_->readers[slot_].pid.load(std::memory_order_acquire) != getpid();
+}
+
+#else // _WIN32
+
+using namespace oop;
+
+struct oop::shm_layout {};
+
+shm_transport::shm_transport(const std::string&, size_t, std::chrono::milliseconds) {
+    throw std::runtime_error("shm_transport: not supported on this platform");
+}
+
+shm_transport::~shm_transport() = default;
+
+void shm_transport::write(const figure_record&) {}
+void shm_transport::flush() {}
+void shm_transport::publish() {}
+void shm_transport::wait_readers(std::uint64_t) {}
+
+shm_reader::shm_reader(const std::string&) {
+    throw std::runtime_error("shm_reader: not supported on this platform");
+}
+
+shm_reader::~shm_reader() = default;
+
+size_t shm_reader::available() const {
+    return 0;
+}
+
+const figure_record& shm_reader::at(size_t) const {
+    throw std::out_of_range("shm_reader: no records");
+}
+
+void shm_reader::consume(size_t) {}
+
+bool shm_reader::closed() const {
+    return true;
+}
+
+bool shm_reader::detached() const {
+    return true;
+}
+
+#endif
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <aggregates.hpp>
+
+using rhombus = basic_polygon<point2d, 4>;
+using hexagon = basic_polygon<point2d, 6>;
+
+namespace {
+    rhombus make_rhombus(const double x, const double y) {
+        rhombus r;
+        r[0] = { x, y };
+        r[1] = { x + 1, y + 1 };
+        r[2] = { x + 2, y };
+        r[3] = { x + 1, y - 1 };
+        return r;
+    }
+
+    hexagon make_hexagon(const double x, const double y) {
+        hexagon h;
+        h[0] = { x, y };
+        h[1] = { x + 1, y };
+        h[2] = { x + 2, y + 1 };
+        h[3] = { x + 1, y + 2 };
+        h[4] = { x, y + 2 };
+        h[5] = { x - 1, y + 1 };
+        return h;
+    }
+}
+
+TEST(p2_quantile, empty_is_nan) {
+    oop::p2_quantile q(0.5);
+    EXPECT_EQ(q.count(), 0u);
+    EXPECT_TRUE(std::isnan(q.value()));
+}
+
+TEST(p2_quantile, few_samples_use_exact_rank) {
+    oop::p2_quantile p50(0.5);
+    for (double x : { 3.0, 1.0, 2.0 }) {
+        p50.add(x);
+    }
+    EXPECT_EQ(p50.count(), 3u);
+    EXPECT_DOUBLE_EQ(p50.value(), 2.0);
+
+    // round(0.9 * 3) = 3 -> fourth of sorted { 1, 2, 3, 4 }
+    oop::p2_quantile p90(0.9);
+    for (double x : { 4.0, 2.0, 1.0, 3.0 }) {
+        p90.add(x);
+    }
+    EXPECT_DOUBLE_EQ(p90.value(), 4.0);
+}
+
+TEST(p2_quantile, reset_forgets_samples) {
+    oop::p2_quantile q(0.5);
+    for (int i = 0; i < 100; i++) {
+        q.add(i);
+    }
+    q.reset();
+    EXPECT_EQ(q.count(), 0u);
+    q.add(42);
+    EXPECT_DOUBLE_EQ(q.value(), 42.0);
+}
+
+TEST(p2_quantile, matches_sorted_reference) {
+    std::mt19937_64                  rng(12345);
+    std::lognormal_distribution<>    dist(0, 1);
+    const size_t                     n = 100000;
+    std::vector<double>              samples(n);
+    oop::p2_quantile                 p50(0.5), p90(0.9), p99(0.99);
+
+    for (auto& x : samples) {
+        x = dist(rng);
+        p50.add(x);
+        p90.add(x);
+        p99.add(x);
+    }
+    std::sort(samples.begin(), samples.end());
+
+    const auto exact = [&](const double p) {
+        return samples[static_cast<size_t>(p * (n - 1))];
+    };
+    EXPECT_NEAR(p50.value(), exact(0.50), exact(0.50) * 0.01);
+    EXPECT_NEAR(p90.value(), exact(0.90), exact(0.90) * 0.02);
+    EXPECT_NEAR(p99.value(), exact(0.99), exact(0.99) * 0.03);
+}
+
+TEST(aggregates, counts_types_and_bounding_box) {
+    oop::aggregates a;
+    a.add(make_rhombus(0, 0));
+    a.add(make_rhombus(10, 5));
+    a.add(make_hexagon(-3, -4));
+
+    const auto total = a.snapshot().total;
+    EXPECT_EQ(total.count, 3u);
+    EXPECT_EQ(total.types.at("rhombus"), 2u);
+    EXPECT_EQ(total.types.at("hexagon"), 1u);
+    EXPECT_EQ(total.types.count("pentagon"), 0u);
+
+    EXPECT_DOUBLE_EQ(total.total_area, 2 + 2 + 4);
+    EXPECT_DOUBLE_EQ(total.mean_area, 8.0 / 3);
+
+    EXPECT_DOUBLE_EQ(total.box.min[0], -4);
+    EXPECT_DOUBLE_EQ(total.box.min[1], -4);
+    EXPECT_DOUBLE_EQ(total.box.max[0], 12);
+    EXPECT_DOUBLE_EQ(total.box.max[1], 6);
+}
+
+TEST(aggregates, new_batch_resets_batch_only) {
+    oop::aggregates a;
+    a.add(make_rhombus(0, 0));
+    a.add(make_rhombus(0, 0));
+
+    auto snapshot = a.snapshot();
+    EXPECT_EQ(snapshot.batch.count, 2u);
+    EXPECT_EQ(snapshot.total.count, 2u);
+
+    a.new_batch();
+    snapshot = a.snapshot();
+    EXPECT_EQ(snapshot.batch.count, 0u);
+    EXPECT_TRUE(snapshot.batch.types.empty());
+    EXPECT_DOUBLE_EQ(snapshot.batch.total_area, 0);
+    EXPECT_EQ(snapshot.total.count, 2u);
+
+    a.add(make_hexagon(100, 100));
+    snapshot = a.snapshot();
+    EXPECT_EQ(snapshot.batch.count, 1u);
+    EXPECT_DOUBLE_EQ(snapshot.batch.p50_area, 4);
+    EXPECT_DOUBLE_EQ(snapshot.batch.box.min[0], 99);
+    EXPECT_EQ(snapshot.total.count, 3u);
+    EXPECT_DOUBLE_EQ(snapshot.total.box.min[0], 0);
+    EXPECT_DOUBLE_EQ(snapshot.total.box.max[0], 102);
+}
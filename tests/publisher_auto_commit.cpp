@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <publisher.hpp>
+#include <subscriber.hpp>
+
+using namespace std::chrono_literals;
+
+namespace {
+    struct sized_event final
+        : oop::event {
+        explicit sized_event(const size_t size = 0)
+            : size_(size)
+        {}
+
+        [[nodiscard]] size_t size() const noexcept override {
+            return size_;
+        }
+
+    private:
+        size_t size_;
+    };
+
+    /*
+        Records size of every delivered batch
+    */
+    struct batch_subscriber final
+        : oop::subscriber {
+        /*!
+         * @brief Wait till n batches are delivered.
+         *
+         * @return
+         * false on timeout
+         */
+        bool wait_batches(const size_t n, const std::chrono::milliseconds timeout = 5s) {
+            std::unique_lock lock(mu_);
+            return cv_.wait_for(lock, timeout, [&] { return batches_.size() >= n; });
+        }
+
+        std::vector<size_t> batches() {
+            std::lock_guard lock(mu_);
+            return batches_;
+        }
+
+    private:
+        std::mutex              mu_;
+        std::condition_variable cv_;
+        std::vector<size_t>     batches_;
+        size_t                  current_ = 0;
+
+        void handle(const oop::event&) override {
+            ++current_;
+        }
+
+        void flush() override {
+            std::lock_guard lock(mu_);
+            batches_.push_back(current_);
+            current_ = 0;
+            cv_.notify_all();
+        }
+    };
+}
+
+TEST(publisher_auto_commit, commits_at_event_count) {
+    batch_subscriber s;
+    oop::publisher   publisher({ 3 });
+    publisher.subscribe(&s);
+
+    publisher.push(std::make_shared<sized_event>());
+    publisher.push(std::make_shared<sized_event>());
+    EXPECT_FALSE(s.wait_batches(1, 100ms));
+    EXPECT_EQ(publisher.pending(), 2u);
+
+    publisher.push(std::make_shared<sized_event>());
+    ASSERT_TRUE(s.wait_batches(1));
+    EXPECT_EQ(s.batches(), std::vector<size_t>{ 3 });
+    EXPECT_EQ(publisher.pending(), 0u);
+}
+
+TEST(publisher_auto_commit, commits_at_byte_count) {
+    batch_subscriber s;
+    oop::publisher   publisher({ 0, 100 });
+    publisher.subscribe(&s);
+
+    publisher.push(std::make_shared<sized_event>(60));
+    EXPECT_FALSE(s.wait_batches(1, 100ms));
+
+    publisher.push(std::make_shared<sized_event>(50));
+    ASSERT_TRUE(s.wait_batches(1));
+    EXPECT_EQ(s.batches(), std::vector<size_t>{ 2 });
+
+    // Byte count starts over with next batch
+    publisher.push(std::make_shared<sized_event>(60));
+    EXPECT_FALSE(s.wait_batches(2, 100ms));
+}
+
+TEST(publisher_auto_commit, commits_after_delay_without_pushes) {
+    batch_subscriber s;
+    oop::publisher   publisher({ 0, 0, 200ms });
+    publisher.subscribe(&s);
+
+    const auto start = oop::publisher::clock_type::now();
+    publisher.push(std::make_shared<sized_event>());
+    publisher.push(std::make_shared<sized_event>());
+
+    ASSERT_TRUE(s.wait_batches(1));
+    EXPECT_GE(oop::publisher::clock_type::now() - start, 200ms);
+    EXPECT_EQ(s.batches(), std::vector<size_t>{ 2 });
+}
+
+TEST(publisher_auto_commit, delivers_pending_on_destruction) {
+    batch_subscriber s;
+    {
+        oop::publisher publisher({ 100, 0, 1h });
+        publisher.subscribe(&s);
+
+        for (int i = 0; i < 3; i++) {
+            publisher.push(std::make_shared<sized_event>());
+        }
+    }
+    EXPECT_EQ(s.batches(), std::vector<size_t>{ 3 });
+}
@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <publisher.hpp>
+#include <subscriber.hpp>
+
+using namespace std::chrono_literals;
+
+namespace {
+    struct test_event final
+        : oop::event {};
+
+    /*
+        Appends its id to shared log on every event
+    */
+    struct recording_subscriber final
+        : oop::subscriber {
+        recording_subscriber(const int id, std::vector<int>& log)
+            : id(id)
+            , log(log)
+        {}
+
+        const int         id;
+        std::vector<int>& log;
+        size_t            flushes = 0;
+
+    private:
+        void handle(const oop::event&) override {
+            log.push_back(id);
+        }
+
+        void flush() override {
+            ++flushes;
+        }
+    };
+
+    /*
+        Blocks in the first handle till released
+    */
+    struct blocking_subscriber final
+        : oop::subscriber {
+        std::promise<void> entered;
+        std::promise<void> release;
+
+    private:
+        bool first_ = true;
+
+        void handle(const oop::event&) override {
+            if (first_) {
+                first_ = false;
+                entered.set_value();
+                release.get_future().wait();
+            }
+        }
+    };
+}
+
+TEST(publisher_priority, higher_class_first_registration_order_within_class) {
+    std::vector<int>     log;
+    recording_subscriber a(1, log), b(2, log), c(3, log), d(4, log), e(5, log);
+
+    oop::publisher publisher;
+    publisher.subscribe(&a, oop::priority::bulk);
+    publisher.subscribe(&b);
+    publisher.subscribe(&c, oop::priority::interactive);
+    publisher.subscribe(&d, oop::priority::normal);
+    publisher.subscribe(&e, oop::priority::interactive);
+
+    publisher.push(std::make_shared<test_event>());
+    publisher.push(std::make_shared<test_event>());
+    publisher.commit();
+
+    // Every subscriber gets whole batch before next one starts
+    const std::vector<int> expected{ 3, 3, 5, 5, 2, 2, 4, 4, 1, 1 };
+    EXPECT_EQ(log, expected);
+}
+
+TEST(publisher_priority, past_deadline_reports_all_in_priority_order) {
+    std::vector<int>     log;
+    recording_subscriber bulk(1, log), normal(2, log), interactive(3, log);
+
+    oop::publisher publisher;
+    publisher.subscribe(&bulk, oop::priority::bulk);
+    publisher.subscribe(&normal);
+    publisher.subscribe(&interactive, oop::priority::interactive);
+
+    publisher.push(std::make_shared<test_event>());
+    const auto report = publisher.commit(oop::publisher::clock_type::now() - 1s);
+
+    EXPECT_TRUE(report.deadline_missed());
+    const std::vector<const oop::subscriber*> expected{ &interactive, &normal, &bulk };
+    EXPECT_EQ(report.missed, expected);
+}
+
+TEST(publisher_priority, no_deadline_reports_nothing) {
+    std::vector<int>     log;
+    recording_subscriber s(1, log);
+
+    oop::publisher publisher;
+    publisher.subscribe(&s);
+
+    publisher.push(std::make_shared<test_event>());
+    const auto report = publisher.commit(std::nullopt);
+
+    EXPECT_FALSE(report.deadline_missed());
+    EXPECT_TRUE(report.missed.empty());
+    EXPECT_EQ(log.size(), 1u);
+}
+
+TEST(publisher_priority, merged_commits_get_own_reports) {
+    std::vector<int>     log;
+    blocking_subscriber  blocker;
+    recording_subscriber s(1, log);
+
+    oop::publisher publisher;
+    publisher.subscribe(&blocker, oop::priority::interactive);
+    publisher.subscribe(&s);
+
+    // Keep routine busy with first commit
+    publisher.push(std::make_shared<test_event>());
+    auto first = std::async(std::launch::async, [&] { return publisher.commit(); });
+    blocker.entered.get_future().wait();
+
+    // Both commits queue while routine is busy and are served by one pass
+    publisher.push(std::make_shared<test_event>());
+    auto late = std::async(std::launch::async, [&] {
+        return publisher.commit(oop::publisher::clock_type::now() - 1s);
+    });
+    auto relaxed = std::async(std::launch::async, [&] {
+        return publisher.commit(oop::publisher::clock_type::now() + 1h);
+    });
+    std::this_thread::sleep_for(200ms);
+    blocker.release.set_value();
+
+    EXPECT_FALSE(first.get().deadline_missed());
+
+    const auto late_report = late.get();
+    const std::vector<const oop::subscriber*> expected{ &blocker, &s };
+    EXPECT_EQ(late_report.missed, expected);
+    EXPECT_FALSE(relaxed.get().deadline_missed());
+
+    EXPECT_EQ(s.flushes, 2u);
+    EXPECT_EQ(log.size(), 2u);
+}
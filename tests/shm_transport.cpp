@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+
+#ifndef _WIN32
+
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <shm_transport.hpp>
+
+using namespace std::chrono_literals;
+
+namespace {
+    auto constexpr no_stall_timeout = std::chrono::milliseconds(0);
+
+    /*
+        Segment name unique for test and process
+    */
+    std::string segment_name(const std::string& test) {
+        return "/oop_test_" + test + "_" + std::to_string(getpid());
+    }
+
+    oop::figure_record make_record(const std::uint32_t id) {
+        oop::figure_record record{};
+        record.vertices = id;
+        return record;
+    }
+
+    template<class _Future>
+    bool blocked(const _Future& future) {
+        return future.wait_for(100ms) == std::future_status::timeout;
+    }
+
+    template<class _Future>
+    bool finished(const _Future& future) {
+        return future.wait_for(5s) == std::future_status::ready;
+    }
+}
+
+TEST(shm_transport, wraps_around_ring) {
+    const auto         name = segment_name("wrap");
+    oop::shm_transport transport(name, 4, no_stall_timeout);
+    oop::shm_reader    reader(name);
+
+    std::vector<std::uint32_t> received;
+    std::thread consumer([&] {
+        while (received.size() < 10) {
+            const auto n = reader.available();
+            for (size_t i = 0; i < n; i++) {
+                received.push_back(reader.at(i).vertices);
+            }
+            reader.consume(n);
+            std::this_thread::sleep_for(1ms);
+        }
+    });
+
+    for (std::uint32_t i = 0; i < 10; i++) {
+        transport.write(make_record(i));
+    }
+    transport.flush();
+    consumer.join();
+
+    const std::vector<std::uint32_t> expected{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    EXPECT_EQ(received, expected);
+}
+
+TEST(shm_transport, write_blocks_on_lagging_reader) {
+    const auto         name = segment_name("lagging");
+    oop::shm_transport transport(name, 2, no_stall_timeout);
+    oop::shm_reader    reader(name);
+
+    transport.write(make_record(0));
+    transport.write(make_record(1));
+
+    // Third record overwrites first one, which reader has not consumed
+    auto write = std::async(std::launch::async, [&] { transport.write(make_record(2)); });
+    EXPECT_TRUE(blocked(write));
+    EXPECT_EQ(reader.available(), 2u);
+    EXPECT_EQ(reader.at(0).vertices, 0u);
+
+    reader.consume(1);
+    EXPECT_TRUE(finished(write));
+}
+
+TEST(shm_transport, flush_returns_after_consume) {
+    const auto         name = segment_name("flush");
+    oop::shm_transport transport(name, 8, no_stall_timeout);
+    oop::shm_reader    reader(name);
+
+    transport.write(make_record(0));
+    transport.write(make_record(1));
+    auto flush = std::async(std::launch::async, [&] { transport.flush(); });
+    EXPECT_TRUE(blocked(flush));
+    EXPECT_EQ(reader.available(), 2u);
+
+    reader.consume(1);
+    EXPECT_TRUE(blocked(flush));
+
+    reader.consume(1);
+    EXPECT_TRUE(finished(flush));
+}
+
+TEST(shm_transport, reader_attaches_at_published) {
+    const auto         name = segment_name("attach");
+    oop::shm_transport transport(name, 4, no_stall_timeout);
+
+    // Nobody is attached, so nothing to wait for
+    for (std::uint32_t i = 0; i < 6; i++) {
+        transport.write(make_record(i));
+    }
+    transport.flush();
+
+    oop::shm_reader reader(name);
+    EXPECT_EQ(reader.available(), 0u);
+
+    transport.write(make_record(6));
+    auto flush = std::async(std::launch::async, [&] { transport.flush(); });
+    EXPECT_TRUE(blocked(flush));
+    ASSERT_EQ(reader.available(), 1u);
+    EXPECT_EQ(reader.at(0).vertices, 6u);
+
+    reader.consume(1);
+    EXPECT_TRUE(finished(flush));
+}
+
+TEST(shm_transport, dead_reader_is_detached) {
+    const auto         name = segment_name("dead");
+    oop::shm_transport transport(name, 4, no_stall_timeout);
+
+    // Child dies attached without releasing its slot
+    const auto child = fork();
+    ASSERT_NE(child, -1);
+    if (child == 0) {
+        new oop::shm_reader(name);
+        _exit(0);
+    }
+    ASSERT_EQ(waitpid(child, nullptr, 0), child);
+
+    transport.write(make_record(0));
+    auto flush = std::async(std::launch::async, [&] { transport.flush(); });
+    EXPECT_TRUE(finished(flush));
+}
+
+TEST(shm_transport, stalled_reader_is_detached) {
+    const auto         name = segment_name("stalled");
+    oop::shm_transport transport(name, 4, 100ms);
+    oop::shm_reader    reader(name);
+
+    transport.write(make_record(0));
+    auto flush = std::async(std::launch::async, [&] { transport.flush(); });
+    EXPECT_TRUE(finished(flush));
+    EXPECT_TRUE(reader.detached());
+}
+
+TEST(shm_transport, keeps_segment_of_live_writer) {
+    const auto         name = segment_name("live");
+    oop::shm_transport transport(name);
+    EXPECT_THROW(oop::shm_transport{ name }, std::runtime_error);
+
+    // Writer is still there for its readers
+    oop::shm_reader reader(name);
+    EXPECT_FALSE(reader.closed());
+}
+
+TEST(shm_transport, replaces_segment_of_dead_writer) {
+    const auto name = segment_name("stale");
+
+    // Child dies without closing its segment
+    const auto child = fork();
+    ASSERT_NE(child, -1);
+    if (child == 0) {
+        new oop::shm_transport(name);
+        _exit(0);
+    }
+    ASSERT_EQ(waitpid(child, nullptr, 0), child);
+
+    oop::shm_transport transport(name);
+    oop::shm_reader    reader(name);
+    EXPECT_FALSE(reader.closed());
+    EXPECT_EQ(reader.available(), 0u);
+}
+
+#endif